@@ -1,6 +1,6 @@
 #pragma once
 
-#include "UnitCore.h"
+#include "UnitCoreLean.h"
 
 DEFINE_BASE_UNIT(0, meters, m);
 
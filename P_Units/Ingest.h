@@ -0,0 +1,538 @@
+#pragma once
+// multi-threaded ingest of unit-tagged records:
+// chunked reading, parallel parsing and conversion on a work-stealing thread pool
+// and ordered, bounded hand-off of typed columns to a sink running on its own thread
+
+#include "UnitCore.h"
+#include <atomic>
+#include <chrono>
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <ios>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+XPU_NAMESPACE_BEGIN(punits)
+XPU_NAMESPACE_BEGIN(ingest)
+
+// column of a record: values are converted to the unit type Target,
+// accepted units of the input are Target and Sources (e.g. Column<UNIT_T(m), UNIT_T(km), UNIT_T(cm)>)
+// units in the input must be written exactly as returned by unitName(), for combined units
+// this is the product of the unit aliases with powers (e.g. "m*s^-1" for UNIT_T(m / s), "km*h^-1" for UNIT_T(km / h))
+template< class Target, class... Sources >
+class Column
+{
+	static_assert((helpers::unit_conversion<typename helpers::to_unit<Sources>::type,
+		typename helpers::to_unit<Target>::type>::is_convertible && ...), "source unit is not convertible to the column unit");
+
+	struct Entry
+	{
+		std::string unit;
+		double factor;
+	};
+
+	// unit names of the input and conversion factors to Target
+	static const std::vector<Entry>& entries()
+	{
+		static const std::vector<Entry> table{ { Target::unitName(), 1.0 }, { Sources::unitName(),
+			helpers::unit_conversion<typename helpers::to_unit<Sources>::type, typename helpers::to_unit<Target>::type>::conversion_factor }... };
+		return table;
+	}
+
+public:
+	typedef Target value_type;
+
+	// parses a field of the form "<value> <unit>", returns false if the field is invalid
+	static bool parse(std::string_view field, Target& result)
+	{
+		constexpr std::string_view whitespace = " \t\r";
+		std::size_t begin = field.find_first_not_of(whitespace);
+		std::size_t end = field.find_last_not_of(whitespace);
+		if (begin == std::string_view::npos) {
+			return false;
+		}
+		field = field.substr(begin, end - begin + 1);
+
+		double val;
+		auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), val);
+		if (ec != std::errc() || !std::isfinite(val)) {
+			return false;
+		}
+		std::string_view unit = field.substr(ptr - field.data());
+		begin = unit.find_first_not_of(whitespace);
+		if (begin == 0 || begin == std::string_view::npos) {
+			return false;
+		}
+		unit = unit.substr(begin);
+
+		for (const Entry& entry : entries()) {
+			if (entry.unit == unit) {
+				result = Target(entry.factor * val);
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+// work-stealing thread pool: every worker has its own task deque, taking tasks from the front (oldest first);
+// idle workers steal from the back of other deques, taking tasks their owner would run last
+// (tasks must not throw, an exception escaping a task terminates the program)
+class ThreadPool
+{
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+public:
+	explicit ThreadPool(std::size_t num_threads)
+	{
+		if (num_threads == 0) {
+			num_threads = 1;
+		}
+		for (std::size_t i = 0; i < num_threads; ++i) {
+			queues.push_back(std::make_unique<Queue>());
+		}
+		for (std::size_t i = 0; i < num_threads; ++i) {
+			workers.emplace_back([this, i] { run(i); });
+		}
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// finishes all submitted tasks before joining the workers
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+	}
+
+	// tasks submitted by a worker go to its own deque, other tasks are distributed round robin
+	void submit(std::function<void()> task)
+	{
+		std::size_t index = (current_pool() == this) ? current_index()
+			: next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+		{
+			std::lock_guard<std::mutex> lock(queues[index]->mutex);
+			queues[index]->tasks.push_back(std::move(task));
+			queued.fetch_add(1);
+		}
+		// the lock orders the notification after a worker's check of queued before sleeping
+		if (sleeping.load() > 0) {
+			std::lock_guard<std::mutex> lock(sleep_mutex);
+		}
+		wake.notify_one();
+	}
+
+	std::size_t size() const { return workers.size(); }
+
+private:
+	static const ThreadPool*& current_pool()
+	{
+		static thread_local const ThreadPool* pool = nullptr;
+		return pool;
+	}
+
+	static std::size_t& current_index()
+	{
+		static thread_local std::size_t index = 0;
+		return index;
+	}
+
+	// only locks the deques, so workers with tasks do not contend with each other
+	bool try_pop(std::size_t index, std::function<void()>& task)
+	{
+		{
+			Queue& own = *queues[index];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if (!own.tasks.empty()) {
+				task = std::move(own.tasks.front());
+				own.tasks.pop_front();
+				queued.fetch_sub(1);
+				return true;
+			}
+		}
+		for (std::size_t i = 1; i < queues.size(); ++i) {
+			Queue& victim = *queues[(index + i) % queues.size()];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (!victim.tasks.empty()) {
+				task = std::move(victim.tasks.back());
+				victim.tasks.pop_back();
+				queued.fetch_sub(1);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void run(std::size_t index)
+	{
+		current_pool() = this;
+		current_index() = index;
+		std::function<void()> task;
+		while (true) {
+			if (try_pop(index, task)) {
+				task();
+				task = nullptr;
+				continue;
+			}
+			// sleep until tasks are queued (queued is changed with the lock of a deque held)
+			std::unique_lock<std::mutex> lock(sleep_mutex);
+			sleeping.fetch_add(1);
+			wake.wait(lock, [this] { return queued.load() > 0 || stopping; });
+			sleeping.fetch_sub(1);
+			if (stopping && queued.load() == 0) {
+				return;
+			}
+		}
+	}
+
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> workers;
+	// number of tasks in all deques
+	std::atomic<std::size_t> queued{ 0 };
+	std::atomic<std::size_t> sleeping{ 0 };
+	std::mutex sleep_mutex;
+	std::condition_variable wake;
+	bool stopping = false;
+	std::atomic<std::size_t> next_queue{ 0 };
+};
+
+struct PipelineOptions
+{
+	// number of bytes read per chunk (chunks are cut at record boundaries)
+	std::size_t chunk_bytes = 1 << 20;
+	// maximum number of chunks read but not yet passed to the sink, 0 means two per thread
+	std::size_t max_in_flight = 0;
+	// number of threads for parsing and conversion, 0 means one less than the hardware threads
+	// (reading runs on the calling thread, the sink on an additional thread)
+	std::size_t threads = 0;
+	char separator = ',';
+};
+
+struct StageStatistics
+{
+	std::size_t records = 0;
+	std::size_t bytes = 0;
+	// for the convert stage, this is the sum over all threads
+	double seconds = 0;
+
+	double records_per_second() const { return seconds > 0 ? records / seconds : 0; }
+};
+
+struct PipelineStatistics
+{
+	// read: lines of the input, convert and sink: valid records
+	StageStatistics read;
+	StageStatistics convert;
+	StageStatistics sink;
+	std::size_t chunks = 0;
+	std::size_t rejected_records = 0;
+	// back-pressure: number of times and time the reader blocked because max_in_flight chunks were pending
+	std::size_t reader_stalls = 0;
+	double reader_stall_seconds = 0;
+	// number of times and time the sink waited for the next chunk in order
+	std::size_t sink_waits = 0;
+	double sink_wait_seconds = 0;
+	double wall_seconds = 0;
+};
+
+// pipeline reading records with one field per column (separated by PipelineOptions::separator),
+// every chunk of records is parsed and converted in parallel and passed in input order to the sink
+template< class... Columns >
+class Pipeline
+{
+public:
+	typedef std::tuple<std::vector<typename Columns::value_type>...> column_data;
+
+	struct Chunk
+	{
+		std::size_t index;
+		std::size_t records;
+		std::size_t rejected_records;
+		column_data columns;
+	};
+
+	explicit Pipeline(PipelineOptions options = PipelineOptions())
+		: options(normalize(options)), pool(this->options.threads) {}
+
+	// reads all records of the input, sink is called with Chunk&& on a separate thread, one chunk at a time
+	// (invalid records are skipped and counted, empty lines are ignored;
+	// exceptions of the sink and read errors of the input (badbit) are propagated)
+	template< class Sink >
+	PipelineStatistics run(std::istream& input, Sink&& sink)
+	{
+		typedef std::chrono::steady_clock clock;
+		auto seconds_since = [](clock::time_point start) {
+			return std::chrono::duration<double>(clock::now() - start).count();
+		};
+		clock::time_point run_start = clock::now();
+
+		// shared with the tasks, which might outlive this call if the sink throws
+		auto state = std::make_shared<SharedState>();
+		PipelineStatistics stats;
+
+		std::thread sink_thread([&] {
+			std::size_t next_sink = 0;
+			try {
+				while (true) {
+					std::unique_lock<std::mutex> lock(state->mutex);
+					auto it = state->finished.find(next_sink);
+					auto ready = [&] {
+						it = state->finished.find(next_sink);
+						return it != state->finished.end() || (state->input_done && next_sink == state->chunks) || state->error;
+					};
+					if (!ready()) {
+						++stats.sink_waits;
+						clock::time_point wait_start = clock::now();
+						state->changed.wait(lock, ready);
+						stats.sink_wait_seconds += seconds_since(wait_start);
+					}
+					if (state->error || it == state->finished.end()) {
+						return;
+					}
+					Result result = std::move(it->second);
+					state->finished.erase(it);
+					lock.unlock();
+
+					if (result.error) {
+						std::rethrow_exception(result.error);
+					}
+					clock::time_point sink_start = clock::now();
+					std::size_t records = result.chunk.records;
+					// lines are counted by the conversion to keep the reader cheap
+					stats.read.records += result.lines;
+					stats.convert.records += records;
+					stats.convert.bytes += result.bytes;
+					stats.convert.seconds += result.seconds;
+					stats.rejected_records += result.chunk.rejected_records;
+					sink(std::move(result.chunk));
+					stats.sink.records += records;
+					stats.sink.seconds += seconds_since(sink_start);
+					++next_sink;
+
+					lock.lock();
+					--state->in_flight;
+					lock.unlock();
+					state->changed.notify_all();
+				}
+			}
+			catch (...) {
+				{
+					std::lock_guard<std::mutex> lock(state->mutex);
+					if (!state->error) {
+						state->error = std::current_exception();
+					}
+				}
+				state->changed.notify_all();
+			}
+		});
+
+		std::size_t next_read = 0;
+		try {
+			std::string rest;
+			while (true) {
+				clock::time_point read_start = clock::now();
+				auto text = std::make_shared<std::string>(std::move(rest));
+				rest.clear();
+				std::size_t old_size = text->size();
+				text->resize(old_size + options.chunk_bytes);
+				input.read(&(*text)[old_size], options.chunk_bytes);
+				text->resize(old_size + static_cast<std::size_t>(input.gcount()));
+				if (text->empty()) {
+					break;
+				}
+				if (input) {
+					// cut at the last complete record, the rest is part of the next chunk
+					std::size_t last = text->rfind('\n');
+					if (last == std::string::npos) {
+						rest = std::move(*text);
+						stats.read.seconds += seconds_since(read_start);
+						continue;
+					}
+					rest.assign(*text, last + 1, std::string::npos);
+					text->resize(last + 1);
+				}
+				stats.read.bytes += text->size();
+				stats.read.seconds += seconds_since(read_start);
+
+				{
+					std::unique_lock<std::mutex> lock(state->mutex);
+					auto ready = [&] { return state->in_flight < options.max_in_flight || state->error; };
+					if (!ready()) {
+						++stats.reader_stalls;
+						clock::time_point wait_start = clock::now();
+						state->changed.wait(lock, ready);
+						stats.reader_stall_seconds += seconds_since(wait_start);
+					}
+					if (state->error) {
+						break;
+					}
+					++state->in_flight;
+				}
+
+				std::size_t index = next_read++;
+				char separator = options.separator;
+				pool.submit([state, text, index, separator] {
+					clock::time_point start = clock::now();
+					Result result{ Chunk{ index, 0, 0, column_data() }, nullptr, 0, text->size(), 0 };
+					try {
+						result.lines = convert_chunk(*text, separator, result.chunk);
+					}
+					catch (...) {
+						result.error = std::current_exception();
+					}
+					result.seconds = std::chrono::duration<double>(clock::now() - start).count();
+					{
+						std::lock_guard<std::mutex> lock(state->mutex);
+						try {
+							state->finished.emplace(index, std::move(result));
+						}
+						catch (...) {
+							// the chunk is lost, stop the pipeline (tasks of the pool must not throw)
+							if (!state->error) {
+								state->error = std::current_exception();
+							}
+						}
+					}
+					state->changed.notify_all();
+				});
+			}
+			// a read error must not look like the end of the input
+			if (input.bad()) {
+				throw std::ios_base::failure("punits::ingest::Pipeline: error reading the input");
+			}
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(state->mutex);
+			if (!state->error) {
+				state->error = std::current_exception();
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			state->input_done = true;
+			state->chunks = next_read;
+		}
+		state->changed.notify_all();
+		sink_thread.join();
+		if (state->error) {
+			std::rethrow_exception(state->error);
+		}
+
+		stats.chunks = next_read;
+		stats.wall_seconds = seconds_since(run_start);
+		return stats;
+	}
+
+	std::size_t threads() const { return pool.size(); }
+
+private:
+	struct Result
+	{
+		Chunk chunk;
+		std::exception_ptr error;
+		double seconds;
+		std::size_t bytes;
+		std::size_t lines;
+	};
+
+	struct SharedState
+	{
+		std::mutex mutex;
+		// signals finished chunks, chunks passed to the sink and errors
+		std::condition_variable changed;
+		std::map<std::size_t, Result> finished;
+		std::size_t in_flight = 0;
+		bool input_done = false;
+		std::size_t chunks = 0;
+		std::exception_ptr error;
+	};
+
+	static PipelineOptions normalize(PipelineOptions options)
+	{
+		if (options.threads == 0) {
+			options.threads = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1;
+		}
+		if (options.chunk_bytes == 0) {
+			options.chunk_bytes = 1;
+		}
+		if (options.max_in_flight == 0) {
+			options.max_in_flight = 2 * options.threads;
+		}
+		return options;
+	}
+
+	// parses all fields of a record, returns false if any field is invalid or the number of fields is wrong
+	template< std::size_t... Is >
+	static bool parse_record(std::string_view record, char separator, std::tuple<typename Columns::value_type...>& values,
+		std::index_sequence<Is...>)
+	{
+		std::string_view fields[sizeof...(Columns)];
+		for (std::size_t i = 0; i < sizeof...(Columns); ++i) {
+			std::size_t end = record.find(separator);
+			if ((end == std::string_view::npos) != (i + 1 == sizeof...(Columns))) {
+				return false;
+			}
+			fields[i] = record.substr(0, end);
+			record.remove_prefix(end == std::string_view::npos ? record.size() : end + 1);
+		}
+		return (Columns::parse(fields[Is], std::get<Is>(values)) && ...);
+	}
+
+	// returns the number of lines of the text
+	static std::size_t convert_chunk(std::string_view text, char separator, Chunk& chunk)
+	{
+		std::size_t lines = 0;
+		constexpr auto indices = std::index_sequence_for<Columns...>();
+		std::tuple<typename Columns::value_type...> values{ typename Columns::value_type(0)... };
+		while (!text.empty()) {
+			std::size_t end = text.find('\n');
+			std::string_view record = text.substr(0, end);
+			text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+			++lines;
+			if (record.find_first_not_of(" \t\r") == std::string_view::npos) {
+				continue;
+			}
+			if (parse_record(record, separator, values, indices)) {
+				std::apply([&](auto&... columns) {
+					std::apply([&](const auto&... vals) { (columns.push_back(vals), ...); }, values);
+				}, chunk.columns);
+				++chunk.records;
+			}
+			else {
+				++chunk.rejected_records;
+			}
+		}
+		return lines;
+	}
+
+	PipelineOptions options;
+	ThreadPool pool;
+};
+
+XPU_NAMESPACE_END(ingest)
+XPU_NAMESPACE_END(punits)
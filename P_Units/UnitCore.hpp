@@ -1,9 +1,9 @@
 #pragma once
-// file containing the metaprogramming structures that are necessary for UnitCore.h
+// file containing the metaprogramming structures that are necessary for UnitCoreLean.h
 
 // prevents warnings for the .hpp file
 // the include gets removed by pragma once
-#include "UnitCore.h"
+#include "UnitCoreLean.h"
 
 XPU_NAMESPACE_BEGIN(helpers)
 
@@ -19,19 +19,6 @@ constexpr double constexpr_pow(double val, int exp)
 	return constexpr_pow(val, exp + 1) / val;
 };
 
-// generate string of a unit type
-template< ConversionPolicy p >
-std::string unit_name(PUnit<p>) {
-	return "";
-}
-
-template< class Head, int power, class... PoUs, ConversionPolicy p >
-std::string unit_name(PUnit<p, PowerOfUnit<Head, power>, PoUs...>) {
-	std::string tail = unit_name(PUnit<p, PoUs...>(0));
-	return Head::unitName() + (power == 1 ? std::string("") : (std::string("^")
-		+ std::to_string(power))) + (tail.empty() ? std::string("") : std::string("*") + tail);
-}
-
 // HELPERS
 template< class, ConversionPolicy >
 struct to_punit;
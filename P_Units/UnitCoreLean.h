@@ -0,0 +1,342 @@
+#pragma once
+
+// lean core of the library: no dependency on <string> or <iostream>
+// (unitName() and name() are only declared, their definitions are in UnitCore.h)
+
+#include "UnitMacros.h"
+
+// standard headers are included by punits.ixx before the module declaration
+// (keep the list there in sync when adding includes here)
+#ifndef XPU_IN_MODULE
+#include <iosfwd>
+#endif
+
+/* --- macro definitions --- */
+
+// allows exporting the library namespace from the punits module (see punits.ixx)
+#ifndef XPU_EXPORT
+#define XPU_EXPORT
+#endif
+
+// enables implicit application of an operator requiring equal unit types (like +, <=, ...)
+#define XPU_MAKE_OPERATOR_IMPLICITELY_APPLYABLE(x_op) \
+	template< ConversionPolicy p, class... Left_PoUs, class... Right_PoUs, typename = std::enable_if_t< \
+		!std::is_same_v<PUnit<p, Left_PoUs...>, PUnit<ConversionPolicy::ImplicitConversion, Right_PoUs...>> && \
+		helpers::unit_conversion<Unit<Right_PoUs...>, Unit<Left_PoUs...>>::is_convertible>> \
+	constexpr auto operator x_op (PUnit<p, Left_PoUs...> left, PUnit<ConversionPolicy::ImplicitConversion, Right_PoUs...> right) \
+	{ \
+		return left x_op PUnit<p, Left_PoUs...>(right); \
+	} \
+	\
+	template< ConversionPolicy p, class... Left_PoUs, class... Right_PoUs, typename = std::enable_if_t< \
+		p != ConversionPolicy::ImplicitConversion && helpers::unit_conversion<Unit<Right_PoUs...>, Unit<Left_PoUs...>>::is_convertible>> \
+	constexpr auto operator x_op (PUnit<ConversionPolicy::ImplicitConversion, Left_PoUs...> left, PUnit<p, Right_PoUs...> right) \
+	{ \
+		return PUnit<p, Right_PoUs...>(left) x_op right; \
+	}
+
+/* --- end of macro definitions --- */
+
+
+XPU_EXPORT XPU_NAMESPACE_BEGIN(punits)
+
+// possible conversion policies for units:
+//    - NoConversion: disables any conversion, values must be accessed manually for conversion
+//    - ExplicitConversion: enables conversions by explicitely calling conversion operator
+//    - ImplicitConversion: enables conversions by conversion operator and implicit conversions
+enum class ConversionPolicy
+{
+	NoConversion,
+	ExplicitConversion,
+	ImplicitConversion
+};
+
+// fwd declarations
+template< typename... Ts >
+class Unit;
+
+template< ConversionPolicy, typename... Ts >
+class PUnit;
+
+template< class U, int pwr >
+struct PowerOfUnit
+{
+	typedef U unit_type;
+	static constexpr int power = pwr;
+	static constexpr std::size_t unit_id = U::unit_id;
+};
+
+#include "UnitCore.hpp"
+
+XPU_NAMESPACE_BEGIN(helpers)
+
+// base of unit definitions, providing unitName() (defined in UnitCore.h)
+template< class U >
+struct unit_base
+{
+	static std::string unitName();
+};
+
+XPU_NAMESPACE_END(helpers)
+
+// core metaprogramming class representing a unit
+template<>
+class Unit<>
+{
+protected:
+	double val;
+
+	constexpr Unit<>(double val) : val(val) {}
+};
+
+template< class... Us, int... powers >
+class Unit<PowerOfUnit<Us, powers>...>
+{
+protected:
+	double val;
+
+	constexpr explicit Unit<PowerOfUnit<Us, powers>...>(double val) : val(val) {}
+};
+
+
+// wrapper for unit, adding the conversion policy
+template<ConversionPolicy policy>
+class PUnit<policy> : Unit<>
+{
+public:
+	constexpr PUnit<policy>(double val) : Unit<>(val) {}
+
+	constexpr operator double() const { return Unit<>::val; }
+
+	constexpr double value() const { return Unit<>::val; }
+
+	// defined in UnitCore.h
+	static std::string unitName();
+
+	std::string name() const;
+
+	// necessary to restrict conversions to stricter policy?
+	template< ConversionPolicy new_p, typename = std::enable_if_t<new_p <= policy> >
+	constexpr operator PUnit<new_p>()
+	{
+		return PUnit<new_p>(value());
+	}
+};
+
+template< ConversionPolicy policy, class... PoUs>
+class PUnit : Unit<PoUs...>
+{
+public:
+	constexpr explicit PUnit<policy, PoUs...>(double val) : Unit<PoUs...>(val) {}
+
+	constexpr double value() const { return  Unit<PoUs...>::val; }
+
+	// defined in UnitCore.h
+	static std::string unitName();
+
+	std::string name() const;
+
+	template< ConversionPolicy new_p, class... NewPoUs, typename ConversionT = helpers::unit_conversion<Unit<PoUs...>, Unit<NewPoUs...>>,
+		typename = std::enable_if_t<policy == ConversionPolicy::ExplicitConversion && (new_p <= policy) && ConversionT::is_convertible> >
+	constexpr explicit operator PUnit<new_p, NewPoUs...>() const
+	{
+		return PUnit<new_p, NewPoUs...>(ConversionT::conversion_factor * value());
+	}
+
+	template< ConversionPolicy new_p, class... NewPoUs, typename ConversionT = helpers::unit_conversion<Unit<PoUs...>, Unit<NewPoUs...>>,
+		typename = std::enable_if_t<policy == ConversionPolicy::ImplicitConversion && (new_p <= policy) && ConversionT::is_convertible>, typename = void >
+	constexpr operator PUnit<new_p, NewPoUs...>() const
+	{
+		return PUnit<new_p, NewPoUs...>(ConversionT::conversion_factor * value());
+	}
+};
+
+// conctruction functions
+template< class... PoUs, ConversionPolicy p >
+constexpr PUnit<p, PoUs...> makeUnit(double val, PUnit<p, PoUs...>)
+{
+	return PUnit<p, PoUs...>(val);
+}
+
+template< ConversionPolicy policy, class... PoUs, ConversionPolicy p >
+constexpr PUnit<policy, PoUs...> makeUnit(double val, PUnit<p, PoUs...>)
+{
+	return PUnit<policy, PoUs...>(val);
+}
+
+XPU_NAMESPACE_BEGIN(definitions)
+
+// operators
+template< ConversionPolicy p, class... PoUs >
+constexpr PUnit<p, PoUs...> operator+ (PUnit<p, PoUs...> left, PUnit<p, PoUs...> right)
+{
+	return PUnit<p, PoUs...>(left.value() + right.value());
+}
+
+XPU_MAKE_OPERATOR_IMPLICITELY_APPLYABLE(+)
+
+template< ConversionPolicy p, class... PoUs >
+constexpr PUnit<p, PoUs...> operator- (PUnit<p, PoUs...> left, PUnit<p, PoUs...> right)
+{
+	return PUnit<p, PoUs...>(left.value() - right.value());
+}
+
+XPU_MAKE_OPERATOR_IMPLICITELY_APPLYABLE(-)
+
+template< ConversionPolicy p, class... Left_PoUs, class... Right_PoUs >
+constexpr helpers::mult_punits_t<Unit<Left_PoUs...>, Unit<Right_PoUs...>, p> operator* (PUnit<p, Left_PoUs...> left, PUnit<p, Right_PoUs...> right)
+{
+	return helpers::mult_punits_t<Unit<Left_PoUs...>, Unit<Right_PoUs...>, p>(left.value() * right.value());
+}
+
+template< ConversionPolicy p, class... PoUs >
+constexpr PUnit<p, PoUs...> operator* (double left, PUnit<p, PoUs...> right)
+{
+	return PUnit<p, PoUs...>(left * right.value());
+}
+
+template< ConversionPolicy p, class... PoUs >
+constexpr PUnit<p, PoUs...> operator* (PUnit<p, PoUs...> left, double right)
+{
+	return PUnit<p, PoUs...>(left.value() * right);
+}
+
+template< ConversionPolicy p, class... Left_PoUs, class... Right_PoUs >
+constexpr helpers::div_punits_t<Unit<Left_PoUs...>, Unit<Right_PoUs...>, p> operator/ (PUnit<p, Left_PoUs...> left, PUnit<p, Right_PoUs...> right)
+{
+	return helpers::div_punits_t<Unit<Left_PoUs...>, Unit<Right_PoUs...>, p>(left.value() / right.value());
+}
+
+template< ConversionPolicy p, class... PoUs >
+constexpr helpers::div_punits_t<Unit<>, Unit<PoUs...>, p> operator/ (double left, PUnit<p, PoUs...> right)
+{
+	return helpers::div_punits_t<Unit<>, Unit<PoUs...>, p>(left / right.value());
+}
+
+template< ConversionPolicy p, class... PoUs >
+constexpr PUnit<p, PoUs...> operator/ (PUnit<p, PoUs...> left, double right)
+{
+	return PUnit<p, PoUs...>(left.value() / right);
+}
+
+template< ConversionPolicy p, class... Left_PoUs, class... Right_PoUs >
+constexpr bool operator< (PUnit<p, Left_PoUs...> left, PUnit<p, Right_PoUs...> right)
+{
+	return left.value() < right.value();
+}
+
+XPU_MAKE_OPERATOR_IMPLICITELY_APPLYABLE(<)
+
+template< ConversionPolicy p, class... Left_PoUs, class... Right_PoUs >
+constexpr bool operator> (PUnit<p, Left_PoUs...> left, PUnit<p, Right_PoUs...> right)
+{
+	return left.value() > right.value();
+}
+
+XPU_MAKE_OPERATOR_IMPLICITELY_APPLYABLE(>)
+
+template< ConversionPolicy p, class... Left_PoUs, class... Right_PoUs >
+constexpr bool operator<= (PUnit<p, Left_PoUs...> left, PUnit<p, Right_PoUs...> right)
+{
+	return left.value() <= right.value();
+}
+
+XPU_MAKE_OPERATOR_IMPLICITELY_APPLYABLE(<=)
+
+template< ConversionPolicy p, class... Left_PoUs, class... Right_PoUs >
+constexpr bool operator>= (PUnit<p, Left_PoUs...> left, PUnit<p, Right_PoUs...> right)
+{
+	return left.value() >= right.value();
+}
+
+XPU_MAKE_OPERATOR_IMPLICITELY_APPLYABLE(>=)
+
+// should equality comparison really be supported? (floating point...)
+template< ConversionPolicy p, class... Left_PoUs, class... Right_PoUs >
+constexpr bool operator== (PUnit<p, Left_PoUs...> left, PUnit<p, Right_PoUs...> right)
+{
+	return left.value() == right.value();
+}
+
+XPU_MAKE_OPERATOR_IMPLICITELY_APPLYABLE(==)
+
+// should equality comparison really be supported? (floating point...)
+template< ConversionPolicy p, class... Left_PoUs, class... Right_PoUs >
+constexpr bool operator!= (PUnit<p, Left_PoUs...> left, PUnit<p, Right_PoUs...> right)
+{
+	return left.value() != right.value();
+}
+
+XPU_MAKE_OPERATOR_IMPLICITELY_APPLYABLE(!=)
+
+// with SFINAE guard for implicit application
+template< ConversionPolicy left_p, class... Left_PoUs, ConversionPolicy right_p, class... Right_PoUs,
+	typename = decltype(std::declval<PUnit<left_p, Left_PoUs...>&>() = std::declval<PUnit<left_p, Left_PoUs...>>() + std::declval<PUnit<right_p, Right_PoUs...>>()) >
+PUnit<left_p, Left_PoUs...>& operator+= (PUnit<left_p, Left_PoUs...>& left, PUnit<right_p, Right_PoUs...> right)
+{
+	return left = left + right;
+}
+
+// with SFINAE guard for implicit application
+template< ConversionPolicy left_p, class... Left_PoUs, ConversionPolicy right_p, class... Right_PoUs,
+	typename = decltype(std::declval<PUnit<left_p, Left_PoUs...>&>() = std::declval<PUnit<left_p, Left_PoUs...>>() - std::declval<PUnit<right_p, Right_PoUs...>>()) >
+PUnit<left_p, Left_PoUs...>& operator-= (PUnit<left_p, Left_PoUs...>& left, PUnit<right_p, Right_PoUs...> right)
+{
+	return left = left - right;
+}
+
+template< ConversionPolicy p, class... PoUs >
+PUnit<p, PoUs...>& operator*= (PUnit<p, PoUs...>& left, double right)
+{
+	return left = left * right;
+}
+
+template< ConversionPolicy p, class... PoUs >
+PUnit<p, PoUs...>& operator/= (PUnit<p, PoUs...>& left, double right)
+{
+	return left = left / right;
+}
+
+template< ConversionPolicy p, class... PoUs >
+constexpr PUnit<p, PoUs...> operator+ (PUnit<p, PoUs...> val)
+{
+	return val;
+}
+
+template< ConversionPolicy p, class... PoUs >
+constexpr PUnit<p, PoUs...> operator- (PUnit<p, PoUs...> val)
+{
+	return PUnit<p, PoUs...>(-val.value());
+}
+
+template< ConversionPolicy p, class... PoUs >
+PUnit<p, PoUs...>& operator++ (PUnit<p, PoUs...>& val)
+{
+	return val += PUnit<p, PoUs...>(1);
+}
+
+template< ConversionPolicy p, class... PoUs >
+PUnit<p, PoUs...>& operator-- (PUnit<p, PoUs...>& val)
+{
+	return val -= PUnit<p, PoUs...>(1);
+}
+
+template< ConversionPolicy p, class... PoUs >
+PUnit<p, PoUs...> operator++ (PUnit<p, PoUs...>& val, int)
+{
+	PUnit<p, PoUs...> temp = val;
+	++val;
+	return temp;
+}
+
+template< ConversionPolicy p, class... PoUs >
+PUnit<p, PoUs...> operator-- (PUnit<p, PoUs...>& val, int)
+{
+	PUnit<p, PoUs...> temp = val;
+	--val;
+	return temp;
+}
+
+XPU_NAMESPACE_END(definitions)
+
+XPU_NAMESPACE_END(punits)
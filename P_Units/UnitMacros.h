@@ -0,0 +1,62 @@
+#pragma once
+// macros for defining and using units, without any dependency on the core templates
+// (can be combined with the punits module, as macros are not exported by modules)
+
+// standard headers are included by punits.ixx before the module declaration
+// (keep the list there in sync when adding includes here)
+#ifndef XPU_IN_MODULE
+#include <type_traits>
+#include <cstddef>
+#endif
+
+// macros beginning with XPU_ are for internal usage (macros for the user begin with PUNITS_)
+#define XPU_NAMESPACE_BEGIN(x) namespace x {
+#define XPU_NAMESPACE_END(x) }
+
+// helper macro for unit definition
+#define XPU_DEF_UNIT_HELPER(x_uid, x_uname, x_is_comb, x_cf, x_dct, x_ualias, x_upolicy) \
+	XPU_NAMESPACE_BEGIN(punits) XPU_NAMESPACE_BEGIN(definitions) \
+	struct x_uname : punits::helpers::unit_base<x_uname> \
+	{ \
+		static constexpr std::size_t unit_id = x_uid; \
+		static constexpr bool is_combined_unit = x_is_comb; \
+		static constexpr double conversion_factor = x_cf; \
+		typedef x_dct decomposition_type; \
+		 \
+		static constexpr const char* unit_alias = #x_ualias; \
+	}; \
+	constexpr PUnit<punits::ConversionPolicy::x_upolicy, punits::PowerOfUnit<x_uname, 1>> x_ualias{ 1.0 }; \
+	XPU_NAMESPACE_END(definitions) XPU_NAMESPACE_END(punits)
+
+// macros for getting unit types
+#define UNIT_T(x) std::remove_const_t<decltype(x)>
+#define UNIT_T_P(x, policy) punits::helpers::punit_set_policy<UNIT_T(x), policy>::type
+
+// using the namespace containing unit definitions and operators
+#define PUNITS_USE_DEFINITIONS using namespace punits::definitions
+
+// explicit instantiation of the string conversions for frequently used unit types:
+// use PUNITS_EXTERN_UNIT in a shared header and PUNITS_INSTANTIATE_UNIT in exactly one source file
+// (the argument is a unit expression like for UNIT_T, e.g. punits::definitions::m;
+// requires UnitCore.h or the punits module and <string>)
+#define PUNITS_EXTERN_UNIT(x) \
+	extern template std::string punits::helpers::unit_name_string(UNIT_T(x)); \
+	extern template std::string punits::helpers::value_name_string(UNIT_T(x))
+
+#define PUNITS_INSTANTIATE_UNIT(x) \
+	template std::string punits::helpers::unit_name_string(UNIT_T(x)); \
+	template std::string punits::helpers::value_name_string(UNIT_T(x))
+
+// macros for unit definitions
+// appending _P to the macro name additionally defines the default conversion policy for the unit
+#define DEFINE_BASE_UNIT_P(x_uid, x_uname, x_ualias, x_upolicy) \
+	XPU_DEF_UNIT_HELPER(x_uid, x_uname, false, 1.0, void, x_ualias, x_upolicy)
+
+#define DEFINE_BASE_UNIT(x_uid, x_uname, x_ualias) \
+	DEFINE_BASE_UNIT_P(x_uid, x_uname, x_ualias, ExplicitConversion)
+
+#define DEFINE_DEPENDENT_UNIT_P(x_uid, x_uname, x_ualias, x_udecomposition_alias, x_uconversionfactor, x_upolicy) \
+	XPU_DEF_UNIT_HELPER(x_uid, x_uname, true, x_uconversionfactor, typename punits::helpers::to_unit<UNIT_T(x_udecomposition_alias)>::type, x_ualias, x_upolicy)
+
+#define DEFINE_DEPENDENT_UNIT(x_uid, x_uname, x_ualias, x_udecomposition_alias, x_uconversionfactor) \
+	DEFINE_DEPENDENT_UNIT_P(x_uid, x_uname, x_ualias, x_udecomposition_alias, x_uconversionfactor, ExplicitConversion)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "UnitCore.h"
 #include "Example_Units.h"
 #include <iostream>
 
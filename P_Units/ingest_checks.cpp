@@ -0,0 +1,180 @@
+#include "Example_Units.h"
+#include "Ingest.h"
+#include <cmath>
+#include <iostream>
+#include <ios>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+
+// checks of the ingest pipeline, returns a non-zero exit code if any check fails
+// (meant to be run with different thread counts under ThreadSanitizer, too)
+
+PUNITS_USE_DEFINITIONS;
+
+typedef punits::ingest::Pipeline<
+	punits::ingest::Column<UNIT_T(m), UNIT_T(km)>,
+	punits::ingest::Column<UNIT_T(s), UNIT_T(min)>> TestPipeline;
+
+int failures = 0;
+
+void check(bool condition, const std::string& description) {
+	if (!condition) {
+		std::cout << "FAILED: " << description << std::endl;
+		++failures;
+	}
+}
+
+// valid records "i m,(i % 7) min" followed by invalid and empty records
+std::string test_input(std::size_t valid_records) {
+	std::ostringstream out;
+	for (std::size_t i = 0; i < valid_records; ++i) {
+		out << i << " m," << i % 7 << " min\n";
+	}
+	out << "\n";                // empty, ignored
+	out << "1 m\n";             // too few fields
+	out << "1 m,2 s,3 s\n";     // too many fields
+	out << "3km,1 s\n";         // no space between value and unit
+	out << "1 kg,1 s\n";        // unknown unit
+	out << "x m,1 s\n";         // invalid value
+	out << "  4 km ,  2 s \r";  // valid, no trailing newline
+	return out.str();
+}
+
+void check_ordering_and_counts(std::size_t threads, std::size_t chunk_bytes) {
+	const std::size_t valid_records = 20000;
+	const std::string prefix = std::to_string(threads) + " threads, " + std::to_string(chunk_bytes) + " bytes per chunk: ";
+	punits::ingest::PipelineOptions options;
+	options.threads = threads;
+	options.chunk_bytes = chunk_bytes;
+	options.max_in_flight = 3;
+	TestPipeline pipeline(options);
+
+	std::istringstream input(test_input(valid_records));
+	std::size_t next_index = 0;
+	std::size_t records = 0;
+	bool ordered = true;
+	bool converted = true;
+	punits::ingest::PipelineStatistics stats = pipeline.run(input, [&](TestPipeline::Chunk&& chunk) {
+		ordered = ordered && chunk.index == next_index++;
+		converted = converted && chunk.records == std::get<0>(chunk.columns).size() && chunk.records == std::get<1>(chunk.columns).size();
+		for (std::size_t i = 0; i < chunk.records; ++i, ++records) {
+			double distance = std::get<0>(chunk.columns)[i].value();
+			double time = std::get<1>(chunk.columns)[i].value();
+			if (records < valid_records) {
+				converted = converted && distance == records && time == 60.0 * (records % 7);
+			}
+			else {
+				converted = converted && distance == 4000 && time == 2;
+			}
+		}
+	});
+
+	check(ordered, prefix + "chunks are passed to the sink in order");
+	check(converted, prefix + "values are converted in order");
+	check(records == valid_records + 1, prefix + "all valid records reach the sink");
+	check(stats.rejected_records == 5, prefix + "invalid records are rejected");
+	check(stats.convert.records == valid_records + 1 && stats.sink.records == valid_records + 1, prefix + "stage statistics count valid records");
+	check(stats.read.records == valid_records + 7, prefix + "read statistics count all lines");
+	check(stats.chunks == next_index, prefix + "number of chunks");
+}
+
+void check_sink_exception(std::size_t threads) {
+	punits::ingest::PipelineOptions options;
+	options.threads = threads;
+	options.chunk_bytes = 64;
+	TestPipeline pipeline(options);
+
+	std::istringstream input(test_input(1000));
+	bool propagated = false;
+	try {
+		pipeline.run(input, [](TestPipeline::Chunk&& chunk) {
+			if (chunk.index == 2) {
+				throw std::runtime_error("sink error");
+			}
+		});
+	}
+	catch (const std::runtime_error&) {
+		propagated = true;
+	}
+	check(propagated, std::to_string(threads) + " threads: exception of the sink is propagated");
+
+	// the pipeline is still usable afterwards
+	std::istringstream second_input(test_input(1000));
+	punits::ingest::PipelineStatistics stats = pipeline.run(second_input, [](TestPipeline::Chunk&&) {});
+	check(stats.sink.records == 1001, std::to_string(threads) + " threads: pipeline is reusable after an exception");
+}
+
+// stream buffer providing the given text and failing afterwards
+class FailingStreamBuffer : public std::streambuf
+{
+public:
+	explicit FailingStreamBuffer(std::string text) : text(std::move(text)) {
+		setg(&this->text[0], &this->text[0], &this->text[0] + this->text.size());
+	}
+
+protected:
+	int_type underflow() override {
+		throw std::runtime_error("read error");
+	}
+
+private:
+	std::string text;
+};
+
+void check_read_error(std::size_t threads, bool stream_exceptions) {
+	const std::string description = std::to_string(threads) + " threads" + (stream_exceptions ? ", badbit exceptions" : "");
+	punits::ingest::PipelineOptions options;
+	options.threads = threads;
+	options.chunk_bytes = 64;
+	TestPipeline pipeline(options);
+
+	FailingStreamBuffer buffer(test_input(100).substr(0, 500));
+	std::istream input(&buffer);
+	if (stream_exceptions) {
+		input.exceptions(std::ios_base::badbit);
+	}
+	bool reported = false;
+	try {
+		pipeline.run(input, [](TestPipeline::Chunk&&) {});
+	}
+	catch (const std::exception&) {
+		reported = true;
+	}
+	check(reported, description + ": read error of the input is propagated");
+}
+
+void check_column_parsing() {
+	typedef punits::ingest::Column<UNIT_T(m), UNIT_T(km), UNIT_T(cm), UNIT_T(miles)> DistanceColumn;
+	UNIT_T(m) result(0);
+	check(DistanceColumn::parse("2.5 km", result) && result.value() == 2500, "km are converted to m");
+	check(DistanceColumn::parse(" 1 miles ", result) && std::abs(result.value() - 1609.344) < 1e-9, "miles are converted to m");
+	check(DistanceColumn::parse("1e2 cm", result) && std::abs(result.value() - 1) < 1e-12, "cm are converted to m");
+	check(!DistanceColumn::parse("1 s", result), "units of other dimensions are rejected");
+	check(!DistanceColumn::parse("inf m", result), "non-finite values are rejected");
+	check(!DistanceColumn::parse("", result), "empty fields are rejected");
+
+	typedef punits::ingest::Column<UNIT_T(m / s), UNIT_T(km / h)> SpeedColumn;
+	UNIT_T(m / s) speed(0);
+	check(SpeedColumn::parse("36 km*h^-1", speed) && std::abs(speed.value() - 10) < 1e-12, "combined units are written like unitName()");
+	check(!SpeedColumn::parse("36 km/h", speed), "other notations of combined units are rejected");
+}
+
+int main() {
+	check_column_parsing();
+	for (std::size_t threads : { 1, 3, 8 }) {
+		check_ordering_and_counts(threads, 1 << 20);
+		check_ordering_and_counts(threads, 1000);
+		// smaller than a record, records span several reads
+		check_ordering_and_counts(threads, 7);
+		check_sink_exception(threads);
+		check_read_error(threads, false);
+		check_read_error(threads, true);
+	}
+
+	if (failures == 0) {
+		std::cout << "all checks passed" << std::endl;
+	}
+	return failures == 0 ? 0 : 1;
+}
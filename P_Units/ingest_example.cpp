@@ -0,0 +1,97 @@
+#include "Example_Units.h"
+#include "Ingest.h"
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+PUNITS_USE_DEFINITIONS;
+
+// columns of the records: a distance converted to meters and a duration converted to seconds
+typedef punits::ingest::Pipeline<
+	punits::ingest::Column<UNIT_T(m), UNIT_T(km), UNIT_T(cm), UNIT_T(miles)>,
+	punits::ingest::Column<UNIT_T(s), UNIT_T(min), UNIT_T(h)>> DistanceTimePipeline;
+
+// writes records like "2.5 km, 3 min" with random units (and some invalid records) to a file
+void generate_records(const std::string& file, std::size_t count) {
+	const char* distance_units[] = { "m", "km", "cm", "miles" };
+	const char* time_units[] = { "s", "min", "h" };
+	std::mt19937 gen(42);
+	std::uniform_real_distribution<double> values(0, 1000);
+	std::ofstream out(file);
+	for (std::size_t i = 0; i < count; ++i) {
+		if (i % 1000 == 999) {
+			out << values(gen) << " kg, " << values(gen) << " s\n";
+			continue;
+		}
+		out << values(gen) << " " << distance_units[gen() % 4] << ", " << values(gen) << " " << time_units[gen() % 3] << "\n";
+	}
+}
+
+void print_statistics(const punits::ingest::PipelineStatistics& stats) {
+	std::cout << "    wall time: " << stats.wall_seconds << " s, " << stats.convert.records / stats.wall_seconds << " records/s" << std::endl;
+	std::cout << "    read: " << stats.read.records_per_second() << " records/s, "
+		<< stats.read.bytes / stats.read.seconds / 1e6 << " MB/s" << std::endl;
+	std::cout << "    convert (per thread): " << stats.convert.records_per_second() << " records/s" << std::endl;
+	std::cout << "    sink: " << stats.sink.records_per_second() << " records/s" << std::endl;
+	std::cout << "    chunks: " << stats.chunks << ", rejected records: " << stats.rejected_records << std::endl;
+	std::cout << "    reader stalls: " << stats.reader_stalls << " (" << stats.reader_stall_seconds << " s), sink waits: "
+		<< stats.sink_waits << " (" << stats.sink_wait_seconds << " s)" << std::endl;
+}
+
+// usage: ingest_example file [number of records]
+// the file is generated if it does not exist (default: 10 million records, about 230 MB),
+// the records are read with 1, 2, 4, ... conversion threads up to one less than the hardware threads
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::cout << "usage: " << argv[0] << " file [number of records]" << std::endl;
+		std::cout << "(the file is generated if it does not exist, default: 10000000 records)" << std::endl;
+		return 1;
+	}
+	std::string file = argv[1];
+	if (!std::ifstream(file)) {
+		std::size_t count = argc > 2 ? std::stoul(argv[2]) : 10000000;
+		std::cout << "generating " << count << " records in " << file << std::endl;
+		generate_records(file, count);
+	}
+
+	std::size_t max_threads = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1;
+	std::vector<std::size_t> thread_counts;
+	for (std::size_t threads = 1; threads < max_threads; threads *= 2) {
+		thread_counts.push_back(threads);
+	}
+	thread_counts.push_back(max_threads);
+
+	std::vector<double> records_per_second;
+	for (std::size_t threads : thread_counts) {
+		punits::ingest::PipelineOptions options;
+		options.threads = threads;
+		DistanceTimePipeline pipeline(options);
+
+		// the sink receives typed columns in input order
+		UNIT_T(m) total_distance(0);
+		UNIT_T(s) total_time(0);
+		std::ifstream input(file, std::ios::binary);
+		punits::ingest::PipelineStatistics stats = pipeline.run(input, [&](DistanceTimePipeline::Chunk&& chunk) {
+			for (UNIT_T(m) distance : std::get<0>(chunk.columns)) {
+				total_distance += distance;
+			}
+			for (UNIT_T(s) time : std::get<1>(chunk.columns)) {
+				total_time += time;
+			}
+		});
+		records_per_second.push_back(stats.convert.records / stats.wall_seconds);
+
+		std::cout << threads << " thread(s): total distance = " << UNIT_T(km)(total_distance).name()
+			<< ", total time = " << UNIT_T(h)(total_time).name() << std::endl;
+		print_statistics(stats);
+	}
+
+	std::cout << std::endl << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+	std::cout << "threads | records/s | speedup" << std::endl;
+	for (std::size_t i = 0; i < thread_counts.size(); ++i) {
+		std::cout << thread_counts[i] << " | " << records_per_second[i] << " | " << records_per_second[i] / records_per_second[0] << std::endl;
+	}
+}
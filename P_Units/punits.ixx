@@ -0,0 +1,19 @@
+// C++20 named module of the library
+// macros (UNIT_T, DEFINE_BASE_UNIT, ...) are not exported by modules, include UnitMacros.h for them
+// (includes should precede the import, some compilers do not support mixing them otherwise):
+//     #include "UnitMacros.h"
+//     import punits;
+module;
+
+// all standard headers of the library (UnitMacros.h, UnitCoreLean.h, UnitCore.h),
+// they are not included by the headers themselves inside the module (XPU_IN_MODULE)
+#include <type_traits>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+export module punits;
+
+#define XPU_IN_MODULE
+#define XPU_EXPORT export
+#include "UnitCore.h"
@@ -0,0 +1,90 @@
+#!/bin/bash
+# Measures the build time of a generated project including the library headers.
+#
+# usage: benchmark/build_time.sh [number of translation units] [baseline git revision]
+#
+# Every translation unit includes a header with 9 unit definitions and uses conversions
+# and operators. The translation units are compiled sequentially with $CXX (default g++)
+# and -O0, once per variant:
+#   lean:     UnitCoreLean.h
+#   full:     UnitCore.h
+#   pch:      UnitCore.h (the header with the unit definitions is precompiled)
+#   module:   UnitMacros.h and import punits (requires -fmodules-ts)
+#   baseline: UnitCore.h of the given git revision (only if a revision is given)
+
+set -e
+
+TUS=${1:-200}
+BASELINE=$2
+CXX=${CXX:-g++}
+REPO=$(cd "$(dirname "$0")/.." && pwd)
+SRC=$REPO/P_Units
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+cd "$DIR"
+
+# header with unit definitions, $1: variant, $2: include line(s)
+write_units_header() {
+	cat > "units_$1.h" <<EOF
+$2
+DEFINE_BASE_UNIT(0, meters, m);
+DEFINE_BASE_UNIT(1, seconds, s);
+DEFINE_BASE_UNIT(2, gram, g);
+DEFINE_DEPENDENT_UNIT(3, kilometers, km, m, 1000);
+DEFINE_DEPENDENT_UNIT(6, minutes, min, s, 60);
+DEFINE_DEPENDENT_UNIT(7, hours, h, min, 60);
+DEFINE_DEPENDENT_UNIT(8, kilogram, kg, g, 1000);
+DEFINE_DEPENDENT_UNIT(10, newton, N, kg * m / s / s, 1);
+DEFINE_DEPENDENT_UNIT(11, joule, J, N * m, 1);
+PUNITS_USE_DEFINITIONS;
+EOF
+}
+
+for i in $(seq 1 "$TUS"); do
+	cat > "tu_$i.inc" <<EOF
+double f_$i(double x) {
+	UNIT_T(m / s) v = UNIT_T(m / s)(x * km / h);
+	UNIT_T(J) e = UNIT_T(J)(1000 * kg * v * v);
+	return (e + 1 * J).value() + (v < 3 * m / s);
+}
+EOF
+done
+
+# $1: variant, remaining arguments: compiler flags
+build() {
+	local variant=$1
+	shift
+	local start
+	start=$(date +%s%N)
+	for i in $(seq 1 "$TUS"); do
+		printf '#include "units_%s.h"\n#include "tu_%s.inc"\n' "$variant" "$i" > "tu_$variant.cpp"
+		"$CXX" -O0 -I"$SRC" -I. "$@" -c "tu_$variant.cpp" -o tu.o
+	done
+	echo "$variant: $(( ($(date +%s%N) - start) / 1000000 )) ms for $TUS translation units"
+}
+
+write_units_header lean '#include "UnitCoreLean.h"'
+build lean -std=c++17
+
+write_units_header full '#include "UnitCore.h"'
+build full -std=c++17
+
+write_units_header pch '#include "UnitCore.h"'
+"$CXX" -O0 -I"$SRC" -std=c++17 -x c++-header units_pch.h -o units_pch.h.gch
+build pch -std=c++17 -Winvalid-pch
+
+if cp "$SRC/punits.ixx" punits.cpp && "$CXX" -std=c++20 -fmodules-ts -I"$SRC" -c punits.cpp -o punits.o 2> /dev/null; then
+	write_units_header module "#include \"UnitMacros.h\"
+import punits;"
+	build module -std=c++20 -fmodules-ts
+else
+	echo "module: skipped, $CXX does not support -fmodules-ts"
+fi
+
+if [ -n "$BASELINE" ]; then
+	mkdir baseline
+	git -C "$REPO" show "$BASELINE:P_Units/UnitCore.h" > baseline/UnitCore.h
+	git -C "$REPO" show "$BASELINE:P_Units/UnitCore.hpp" > baseline/UnitCore.hpp
+	write_units_header baseline '#include "baseline/UnitCore.h"'
+	build baseline -std=c++17
+fi